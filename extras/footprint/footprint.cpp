@@ -0,0 +1,45 @@
+// Footprint probe for the footprint_* PlatformIO environments.
+// Each configuration's RAM/Flash usage is reported at the end of its build.
+#include <Arduino.h>
+#include <Wire.h>
+#include "pcf8563.h"
+
+static_assert(sizeof(PCF8563_Class) <= 2 * sizeof(void *), "PCF8563_Class should only hold the bus and address");
+
+PCF8563_Class rtc[3];
+
+void setup()
+{
+    Serial.begin(115200);
+    Wire.begin();
+
+    for (uint8_t i = 0; i < 3; ++i) {
+        rtc[i].begin(Wire);
+    }
+
+    rtc[0].check();
+    rtc[0].setAlarm(RTC_Alarm(30, 12, PCF8563_NO_ALARM, PCF8563_NO_ALARM));
+    rtc[0].enableAlarm();
+    rtc[0].enableCLK(PCF8563_CLK_1HZ);
+
+#if PCF8563_ENABLE_TIMER
+    rtc[1].setTimer(10, 2, true);
+    rtc[1].enableTimer();
+#endif
+
+#if PCF8563_ENABLE_SYNC
+    rtc[2].syncToRtcPrecise();
+#endif
+}
+
+void loop()
+{
+#if PCF8563_ENABLE_FORMAT
+    Serial.println(rtc[0].formatDateTime(PCF_TIMEFORMAT_YYYY_MM_DD_H_M_S));
+#else
+    RTC_Date now = rtc[0].getDateTime();
+    Serial.println(now.second);
+#endif
+
+    delay(1000);
+}
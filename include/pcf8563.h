@@ -1,5 +1,5 @@
 /**
- * pcf8563.h - Arduino library for NXP PCF8563 RTC chip.
+ * pcf8563.h - Arduino library for NXP PCF8563 RTC chip and its BM8563, HYM8563 and PCF85063A relatives.
  * Created by Lewis he on April 1, 2019.
  * github:https://github.com/lewisxhe/PCF8563_Library
  */
@@ -13,6 +13,28 @@
 #include "rtc_alarm.h"
 #include "rtc_date.h"
 
+//! FEATURES
+// Define PCF8563_LEAN, or any of these as 0, to leave the matching code and storage out of the build.
+// Set them as global build flags (e.g. build_flags = -DPCF8563_LEAN); a #define in the sketch before
+// the include only hides the declarations, pcf8563.cpp is still compiled with the defaults.
+#ifdef PCF8563_LEAN
+#define PCF8563_FEATURE_DEFAULT 0
+#else
+#define PCF8563_FEATURE_DEFAULT 1
+#endif
+
+#ifndef PCF8563_ENABLE_FORMAT
+#define PCF8563_ENABLE_FORMAT   PCF8563_FEATURE_DEFAULT //formatDateTime()
+#endif
+
+#ifndef PCF8563_ENABLE_SYNC
+#define PCF8563_ENABLE_SYNC     PCF8563_FEATURE_DEFAULT //syncTo*(), needs <time.h> and <sys/time.h>
+#endif
+
+#ifndef PCF8563_ENABLE_TIMER
+#define PCF8563_ENABLE_TIMER    PCF8563_FEATURE_DEFAULT //Countdown timer
+#endif
+
 #define PCF8563_SLAVE_ADDRESS   (0x51) //7-bit I2C Address
 
 //! REG MAP
@@ -46,10 +68,44 @@
 #define PCF8563_TIMER_TIE       (0x01)
 #define PCF8563_TIMER_TE        (0x80)
 #define PCF8563_TIMER_TD10      (0x03)
+#define PCF8563_TIMER_TI_TP     (0x10)
 
 #define PCF8563_NO_ALARM        (0xFF)
 #define PCF8563_ALARM_ENABLE    (0x80)
 #define PCF8563_CLK_ENABLE      (0x80)
+#define PCF8563_CLK_UNSUPPORTED (0xFF)
+
+#define PCF8563_STOP_BIT        (0x20)
+#define PCF8563_STOP_RELEASE_US (507813)  //First seconds increment after STOP is released (datasheet 8.11)
+#define PCF8563_SYNC_SETUP_US   (5000)    //Time budget for writing STOP and the time registers
+#define PCF8563_SYNC_TIMEOUT_US (1100000) //Give up waiting for a seconds rollover after this long
+
+#define PCF8563_FORMAT_LEN      (24)      //Longest formatDateTime() output, "65535-12-31/23:59:59"
+
+//! PCF85063A REG MAP
+#define PCF85063_CTRL1_REG      (0x00)
+#define PCF85063_CTRL2_REG      (0x01)
+#define PCF85063_OFFSET_REG     (0x02)
+#define PCF85063_SEC_REG        (0x04)
+#define PCF85063_ALRM_MIN_REG   (0x0C)
+#define PCF85063_TIMER_VAL_REG  (0x10)
+#define PCF85063_TIMER_MODE_REG (0x11)
+
+#define PCF85063_CTRL1_KEEP     (0x07) //CAP_SEL, 12_24 and CIE survive STOP writes
+#define PCF85063_ALARM_AIE      (0x80)
+#define PCF85063_ALARM_AF       (0x40)
+#define PCF85063_TIMER_TF       (0x08)
+#define PCF85063_CLK_COF_MASK   (0x07)
+#define PCF85063_CLK_OFF        (0x07)
+#define PCF85063_TIMER_TE       (0x04)
+#define PCF85063_TIMER_TIE      (0x02)
+#define PCF85063_TIMER_TI_TP    (0x01)
+#define PCF85063_TIMER_TCF_POS  (3)
+#define PCF85063_OFFSET_MODE    (0x80) //Coarse mode, correction every 4 minutes instead of every 2 hours
+#define PCF85063_OFFSET_MASK    (0x7F)
+#define PCF85063_OFFSET_MIN     (-64)
+#define PCF85063_OFFSET_MAX     (63)
+#define PCF85063_OFFSET_PPB     (4340) //Per LSB in normal mode
 
 enum {
     PCF8563_CLK_32_768KHZ,
@@ -68,10 +124,103 @@ enum {
     PCF_TIMEFORMAT_YYYY_MM_DD_H_M_S,
 };
 
-class PCF8563_Class
+//! CHIP VARIANTS
+// Register addresses and masks per chip. Everything is a compile-time constant, so
+// PCF8563_Driver<Chip> folds the differences away instead of branching on them at runtime.
+// A bit that a chip keeps in another register is 0 in the mask for the register it is not in.
+struct PCF8563_Chip
+{
+    static const uint8_t ADDRESS          = PCF8563_SLAVE_ADDRESS;
+    static const uint8_t CTRL1_REG        = PCF8563_STAT1_REG;
+    static const uint8_t CTRL1_KEEP       = 0x00;
+    static const uint8_t CTRL2_REG        = PCF8563_STAT2_REG;
+    static const uint8_t SEC_REG          = PCF8563_SEC_REG;
+    static const uint8_t ALRM_MIN_REG     = PCF8563_ALRM_MIN_REG;
+    static const uint8_t CENTURY_MASK     = PCF8563_CENTURY_MASK;
+    static const uint8_t ALARM_AF         = PCF8563_ALARM_AF;
+    static const uint8_t ALARM_AIE        = PCF8563_ALARM_AIE;
+    static const uint8_t TIMER_TF         = PCF8563_TIMER_TF;
+    static const uint8_t CTRL2_TIE        = PCF8563_TIMER_TIE;
+    static const uint8_t CTRL2_TI_TP      = PCF8563_TIMER_TI_TP;
+    static const uint8_t TIMER_CTL_REG    = PCF8563_TIMER1_REG;
+    static const uint8_t TIMER_VAL_REG    = PCF8563_TIMER2_REG;
+    static const uint8_t TIMER_TE         = PCF8563_TIMER_TE;
+    static const uint8_t TIMER_CTL_TIE    = 0x00;
+    static const uint8_t TIMER_CTL_TI_TP  = 0x00;
+    static const uint8_t TIMER_FREQ_POS   = 0;
+    static const uint8_t CLK_REG          = PCF8563_SQW_REG;
+    static const uint8_t CLK_KEEP         = 0x00;
+    static const uint8_t CLK_OFF          = 0x00;
+    static const bool    HAS_OFFSET       = false;
+    static const uint8_t OFFSET_REG       = 0x00;
+
+    static uint8_t clk(uint8_t freq)
+    {
+        return freq | PCF8563_CLK_ENABLE;
+    }
+};
+
+// Same register map and bus behaviour.
+struct BM8563_Chip : PCF8563_Chip
+{
+};
+
+// Same register map. A stop after the register address write is not accepted; the driver's repeated start read covers it.
+struct HYM8563_Chip : PCF8563_Chip
+{
+};
+
+// PCF85063A: time registers start at 0x04, CLKOUT shares CTRL2, the timer has its own mode register,
+// there is no century bit, and an offset register corrects drift in hardware.
+struct PCF85063_Chip
+{
+    static const uint8_t ADDRESS          = PCF8563_SLAVE_ADDRESS;
+    static const uint8_t CTRL1_REG        = PCF85063_CTRL1_REG;
+    static const uint8_t CTRL1_KEEP       = PCF85063_CTRL1_KEEP;
+    static const uint8_t CTRL2_REG        = PCF85063_CTRL2_REG;
+    static const uint8_t SEC_REG          = PCF85063_SEC_REG;
+    static const uint8_t ALRM_MIN_REG     = PCF85063_ALRM_MIN_REG;
+    static const uint8_t CENTURY_MASK     = 0x00;
+    static const uint8_t ALARM_AF         = PCF85063_ALARM_AF;
+    static const uint8_t ALARM_AIE        = PCF85063_ALARM_AIE;
+    static const uint8_t TIMER_TF         = PCF85063_TIMER_TF;
+    static const uint8_t CTRL2_TIE        = 0x00;
+    static const uint8_t CTRL2_TI_TP      = 0x00;
+    static const uint8_t TIMER_CTL_REG    = PCF85063_TIMER_MODE_REG;
+    static const uint8_t TIMER_VAL_REG    = PCF85063_TIMER_VAL_REG;
+    static const uint8_t TIMER_TE         = PCF85063_TIMER_TE;
+    static const uint8_t TIMER_CTL_TIE    = PCF85063_TIMER_TIE;
+    static const uint8_t TIMER_CTL_TI_TP  = PCF85063_TIMER_TI_TP;
+    static const uint8_t TIMER_FREQ_POS   = PCF85063_TIMER_TCF_POS;
+    static const uint8_t CLK_REG          = PCF85063_CTRL2_REG;
+    static const uint8_t CLK_KEEP         = (uint8_t)~PCF85063_CLK_COF_MASK;
+    static const uint8_t CLK_OFF          = PCF85063_CLK_OFF;
+    static const bool    HAS_OFFSET       = true;
+    static const uint8_t OFFSET_REG       = PCF85063_OFFSET_REG;
+
+    static uint8_t clk(uint8_t freq)
+    {
+        switch (freq) {
+            case PCF8563_CLK_32_768KHZ:
+                return 0x00;
+
+            case PCF8563_CLK_1024KHZ:
+                return 0x05;
+
+            case PCF8563_CLK_1HZ:
+                return 0x06;
+
+            default:
+                return PCF8563_CLK_UNSUPPORTED;
+        }
+    }
+};
+
+template <typename Chip>
+class PCF8563_Driver
 {
     public:
-        uint8_t begin(TwoWire &port = Wire, uint8_t addr = PCF8563_SLAVE_ADDRESS);
+        uint8_t begin(TwoWire &port = Wire, uint8_t addr = Chip::ADDRESS);
         void check();
         void setDateTime(
             uint16_t year,
@@ -81,14 +230,14 @@ class PCF8563_Class
             uint8_t minute,
             uint8_t second
         );
-        void setDateTime(RTC_Date date);
+        void setDateTime(const RTC_Date &date);
         RTC_Date getDateTime();
         RTC_Alarm getAlarm();
         void enableAlarm();
         void disableAlarm();
         bool alarmActive();
         void resetAlarm();
-        void setAlarm(RTC_Alarm alarm);
+        void setAlarm(const RTC_Alarm &alarm);
         void setAlarm(uint8_t hour, uint8_t minute, uint8_t day, uint8_t weekday);
         bool isVaild();
         bool isValid();
@@ -96,20 +245,36 @@ class PCF8563_Class
         void setAlarmByHours(uint8_t hour);
         void setAlarmByDays(uint8_t day);
         void setAlarmByMinutes(uint8_t minute);
+    #if PCF8563_ENABLE_TIMER
         bool isTimerEnable();
         bool isTimerActive();
         void enableTimer();
         void disableTimer();
         void setTimer(uint8_t val, uint8_t freq, bool enIntrrupt);
         void clearTimer();
+    #endif
         bool enableCLK(uint8_t freq);
         void disableCLK();
+        bool setOffset(int8_t steps, bool coarse = false);
+        int8_t getOffset();
+        bool correctDrift(int32_t ppb);
+    #if PCF8563_ENABLE_SYNC
     #ifdef ESP32
         void syncToSystem();
+        // errorUs: +/- bound on the captured seconds edge, i.e. half the polling interval
+        bool syncToSystemPrecise(int32_t *errorUs = NULL);
     #endif
-        bool syncToRtc(bool useGmt);
+        bool syncToRtc(bool useGmt = false);
         bool syncToRtcUsingGmt();
+        // errorUs: signed STOP release error against the target, positive when the RTC lags
+        bool syncToRtcPrecise(bool useGmt = false, int32_t *errorUs = NULL);
+    #endif
+    #if PCF8563_ENABLE_FORMAT
+        // Returns one buffer shared by every instance and chip variant; the next call overwrites it.
+        // Use the buf/len overload to format several instances at once or from several tasks.
         const char *formatDateTime(uint8_t sytle = PCF_TIMEFORMAT_HMS);
+        char *formatDateTime(char *buf, size_t len, uint8_t sytle = PCF_TIMEFORMAT_HMS);
+    #endif
         uint32_t getDayOfWeek(uint32_t day, uint32_t month, uint32_t year);
         uint8_t status2();
 
@@ -124,14 +289,14 @@ class PCF8563_Class
             return ( (val / 10 * 16) + (val % 10) );
         }
 
-        int _readByte(uint8_t reg, int nbytes, uint8_t *data)
+        int _readByte(uint8_t reg, uint8_t nbytes, uint8_t *data)
         {
             _i2cPort->beginTransmission(_address);
             _i2cPort->write(reg);
 
             //Adapt to HYM8563, no stop bit is sent after reading the sending register address
             _i2cPort->endTransmission(false);
-            _i2cPort->requestFrom(_address, nbytes, 1);  //HYM8563 send stopbit
+            _i2cPort->requestFrom(_address, nbytes, (uint8_t)1);  //HYM8563 send stopbit
 
             uint8_t index = 0;
             while (_i2cPort->available()) {
@@ -154,13 +319,20 @@ class PCF8563_Class
             return 0;
         }
 
-        uint8_t _isValid = false;
-        int _address;
-        bool _init = false;
+        // Register scratch space lives on the stack of each call; an instance is just the bus and address.
         TwoWire *_i2cPort;
-        uint8_t _data[16];
-        bool _voltageLow;
-        char format[128];
+        uint8_t _address;
 };
 
+typedef PCF8563_Driver<PCF8563_Chip>  PCF8563_Class;
+typedef PCF8563_Driver<BM8563_Chip>   BM8563_Class;
+typedef PCF8563_Driver<HYM8563_Chip>  HYM8563_Class;
+typedef PCF8563_Driver<PCF85063_Chip> PCF85063_Class;
+
+// Instantiated once in pcf8563.cpp.
+extern template class PCF8563_Driver<PCF8563_Chip>;
+extern template class PCF8563_Driver<BM8563_Chip>;
+extern template class PCF8563_Driver<HYM8563_Chip>;
+extern template class PCF8563_Driver<PCF85063_Chip>;
+
 #endif
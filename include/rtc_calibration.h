@@ -0,0 +1,79 @@
+#pragma once
+
+// Technically we shouldn't need ifndef/define/endif here, but it's just incase of any compiler oddness.
+#ifndef RTC_CALIBRATION_H
+#define RTC_CALIBRATION_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <stdint.h>
+#endif
+
+#define RTC_CALIBRATION_MAX_PPB (100000000) //Reject windows that claim more than 10% error
+#define RTC_CALIBRATION_REBASE  (1UL << 30) //Move the anchor forward before the raw delta can wrap
+#define RTC_CALIBRATION_MAX_PENDING (1UL << 31) //Unprocessed window time kept before older windows are dropped
+
+/**
+ * Measures the MCU timebase against the RTC's CLKOUT and corrects it.
+ *
+ * Reference edges are gated over a window of MCU time; the number of CLKOUT
+ * periods in that window gives the MCU clock error in ppb. A window in which an
+ * edge was missed is discarded. edge() is ISR safe and can also be fed a
+ * recorded or synthetic edge stream on the host.
+ * Call update() (or micros(), which calls it) at least every ~35 minutes;
+ * windows older than RTC_CALIBRATION_MAX_PENDING of unprocessed time are dropped.
+ * correct() handles any gap between calls shorter than 2^32 us, like micros().
+ * refHz must match the frequency passed to enableCLK(); 32768 Hz is only
+ * practical with a hardware counter or when replaying.
+ */
+class RTC_Calibration
+{
+    public:
+        RTC_Calibration(uint32_t refHz = 1024, uint32_t windowUs = 1000000);
+
+    #ifdef ARDUINO
+        void begin(uint8_t pin);
+        void end();
+        uint32_t micros();
+    #endif
+        bool edge(uint32_t mcuUs);
+        bool addWindow(uint32_t periods, uint32_t elapsedUs, uint32_t endUs);
+        bool update();
+        uint32_t correct(uint32_t rawUs);
+        int32_t ppb();
+        float ppm();
+        bool isCalibrated();
+        void setWindow(uint32_t windowUs);
+        void setSmoothing(uint8_t shift);
+
+    private:
+        int64_t _delta(uint32_t rawUs);
+        uint32_t _map(uint32_t rawUs);
+
+    #ifdef ARDUINO
+        static void _isr();
+        static RTC_Calibration *_active;
+        uint8_t _pin;
+    #endif
+        uint32_t _refHz;
+        uint32_t _windowUs;
+        uint32_t _gapUs;
+        uint8_t _smoothing = 2;
+        bool _calibrated   = false;
+        int32_t _ppb       = 0;
+        uint32_t _anchorRaw = 0;
+        uint32_t _anchorOut = 0;
+        uint32_t _lastOut   = 0;
+        bool _hasOut        = false;
+
+        // Shared with edge(), which may run in interrupt context.
+        volatile uint32_t _edges          = 0;
+        volatile uint32_t _first          = 0;
+        volatile uint32_t _last           = 0;
+        volatile uint32_t _pendingPeriods = 0;
+        volatile uint32_t _pendingUs      = 0;
+        volatile uint32_t _pendingEnd     = 0;
+};
+
+#endif
@@ -27,7 +27,7 @@ class RTC_Date
         uint8_t minute;
         uint8_t second;
 
-        bool operator==(RTC_Date d);
+        bool operator==(const RTC_Date &d) const;
 
     private:
         uint8_t StringToUint8(const char *pString);
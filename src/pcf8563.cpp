@@ -4,14 +4,25 @@
  * github:https://github.com/lewisxhe/PCF8563_Library
  */
 #include <Arduino.h>
-#include <time.h>
-#include <sys/time.h>
 #include <Wire.h>
 #include "pcf8563.h"
 #include "rtc_date.h"
 #include "rtc_alarm.h"
 
-uint8_t PCF8563_Class::begin(TwoWire &port, uint8_t addr) {
+#if PCF8563_ENABLE_SYNC
+#include <time.h>
+#include <sys/time.h>
+
+static int64_t systemTimeUs() {
+    struct timeval now;
+    gettimeofday(&now, NULL);
+
+    return (int64_t)now.tv_sec * 1000000 + now.tv_usec;
+}
+#endif
+
+template <typename Chip>
+uint8_t PCF8563_Driver<Chip>::begin(TwoWire &port, uint8_t addr) {
     _i2cPort = &port;
     _address = addr;
     _i2cPort->beginTransmission(_address);
@@ -19,7 +30,8 @@ uint8_t PCF8563_Class::begin(TwoWire &port, uint8_t addr) {
     return _i2cPort->endTransmission();
 }
 
-void PCF8563_Class::check() {
+template <typename Chip>
+void PCF8563_Driver<Chip>::check() {
     RTC_Date now      = getDateTime();
     RTC_Date compiled = RTC_Date(__DATE__, __TIME__);
 
@@ -32,11 +44,13 @@ void PCF8563_Class::check() {
     }
 }
 
-void PCF8563_Class::setDateTime(RTC_Date date) {
+template <typename Chip>
+void PCF8563_Driver<Chip>::setDateTime(const RTC_Date &date) {
     setDateTime(date.year, date.month, date.day, date.hour, date.minute, date.second);
 }
 
-uint32_t PCF8563_Class::getDayOfWeek(uint32_t day, uint32_t month, uint32_t year) {
+template <typename Chip>
+uint32_t PCF8563_Driver<Chip>::getDayOfWeek(uint32_t day, uint32_t month, uint32_t year) {
     uint32_t val;
 
     if (month < 3) {
@@ -52,7 +66,8 @@ uint32_t PCF8563_Class::getDayOfWeek(uint32_t day, uint32_t month, uint32_t year
     return (val - 1);
 }
 
-void PCF8563_Class::setDateTime(
+template <typename Chip>
+void PCF8563_Driver<Chip>::setDateTime(
     uint16_t year,
     uint8_t  month,
     uint8_t  day,
@@ -60,249 +75,372 @@ void PCF8563_Class::setDateTime(
     uint8_t  minute,
     uint8_t  second
 ) {
-    _data[0] = _dec_to_bcd(second) & (~PCF8563_VOL_LOW_MASK);
-    _data[1] = _dec_to_bcd(minute);
-    _data[2] = _dec_to_bcd(hour);
-    _data[3] = _dec_to_bcd(day);
-    _data[4] = getDayOfWeek(day, month, year);
-    _data[5] = _dec_to_bcd(month);
-    _data[6] = _dec_to_bcd(year % 100);
+    uint8_t data[7];
+
+    data[0] = _dec_to_bcd(second) & (~PCF8563_VOL_LOW_MASK);
+    data[1] = _dec_to_bcd(minute);
+    data[2] = _dec_to_bcd(hour);
+    data[3] = _dec_to_bcd(day);
+    data[4] = getDayOfWeek(day, month, year);
+    data[5] = _dec_to_bcd(month);
+    data[6] = _dec_to_bcd(year % 100);
 
     if ((2000 % year) == 2000) {
-        _data[5] &= (~PCF8563_CENTURY_MASK);
+        data[5] &= (~Chip::CENTURY_MASK);
     } else {
-        _data[5] |= PCF8563_CENTURY_MASK;
+        data[5] |= Chip::CENTURY_MASK;
     }
 
-    _writeByte(PCF8563_SEC_REG, 7, _data);
+    _writeByte(Chip::SEC_REG, 7, data);
 }
 
 // [[deprecated("Use isValid() instead.")]]
+template <typename Chip>
 __attribute__((deprecated("Use isValid() instead.")))
-bool PCF8563_Class::isVaild() {
+bool PCF8563_Driver<Chip>::isVaild() {
     return isValid();
 }
 
-bool PCF8563_Class::isValid() {
-    _readByte(PCF8563_SEC_REG, 1, &_isValid);
-    return !(_isValid & (1 << 7));
+template <typename Chip>
+bool PCF8563_Driver<Chip>::isValid() {
+    uint8_t data;
+
+    _readByte(Chip::SEC_REG, 1, &data);
+    return !(data & (1 << 7));
 }
 
-RTC_Date PCF8563_Class::getDateTime() {
+template <typename Chip>
+RTC_Date PCF8563_Driver<Chip>::getDateTime() {
     uint16_t year;
     uint8_t  century = 0;
-
-    _readByte(PCF8563_SEC_REG, 7, _data);
-    _voltageLow = (_data[0] & PCF8563_VOL_LOW_MASK);
-    _data[0]    = _bcd_to_dec(_data[0] & (~PCF8563_VOL_LOW_MASK));
-    _data[1]    = _bcd_to_dec(_data[1] & PCF8563_minuteS_MASK);
-    _data[2]    = _bcd_to_dec(_data[2] & PCF8563_HOUR_MASK);
-    _data[3]    = _bcd_to_dec(_data[3] & PCF8563_DAY_MASK);
-    _data[4]    = _bcd_to_dec(_data[4] & PCF8563_WEEKDAY_MASK);
-    century     = _data[5] & PCF8563_CENTURY_MASK;
-    _data[5]    = _bcd_to_dec(_data[5] & PCF8563_MONTH_MASK);
-    year        = _bcd_to_dec(_data[6]);
+    uint8_t  data[7];
+
+    _readByte(Chip::SEC_REG, 7, data);
+    data[0]     = _bcd_to_dec(data[0] & (~PCF8563_VOL_LOW_MASK));
+    data[1]     = _bcd_to_dec(data[1] & PCF8563_minuteS_MASK);
+    data[2]     = _bcd_to_dec(data[2] & PCF8563_HOUR_MASK);
+    data[3]     = _bcd_to_dec(data[3] & PCF8563_DAY_MASK);
+    data[4]     = _bcd_to_dec(data[4] & PCF8563_WEEKDAY_MASK);
+    century     = data[5] & Chip::CENTURY_MASK;
+    data[5]     = _bcd_to_dec(data[5] & PCF8563_MONTH_MASK);
+    year        = _bcd_to_dec(data[6]);
     year        = century ? 1900 + year : 2000 + year;
 
-    return RTC_Date(year, _data[5], _data[3], _data[2], _data[1], _data[0]);
+    return RTC_Date(year, data[5], data[3], data[2], data[1], data[0]);
 }
 
-RTC_Alarm PCF8563_Class::getAlarm() {
-    _readByte(PCF8563_ALRM_MIN_REG, 4, _data);
-    _data[0] = _bcd_to_dec(_data[0] & (~PCF8563_minuteS_MASK));
-    _data[1] = _bcd_to_dec(_data[1] & (~PCF8563_HOUR_MASK));
-    _data[2] = _bcd_to_dec(_data[2] & (~PCF8563_DAY_MASK));
-    _data[3] = _bcd_to_dec(_data[3] & (~PCF8563_WEEKDAY_MASK));
+template <typename Chip>
+RTC_Alarm PCF8563_Driver<Chip>::getAlarm() {
+    uint8_t data[4];
+
+    _readByte(Chip::ALRM_MIN_REG, 4, data);
+    data[0] = _bcd_to_dec(data[0] & (~PCF8563_minuteS_MASK));
+    data[1] = _bcd_to_dec(data[1] & (~PCF8563_HOUR_MASK));
+    data[2] = _bcd_to_dec(data[2] & (~PCF8563_DAY_MASK));
+    data[3] = _bcd_to_dec(data[3] & (~PCF8563_WEEKDAY_MASK));
 
-    return RTC_Alarm(_data[0], _data[1], _data[2], _data[3]);
+    return RTC_Alarm(data[0], data[1], data[2], data[3]);
 }
 
-void PCF8563_Class::enableAlarm() {
-    _readByte(PCF8563_STAT2_REG, 1, _data);
-    _data[0] &= ~PCF8563_ALARM_AF;
-    _data[0] |= (PCF8563_TIMER_TF | PCF8563_ALARM_AIE);
-    _writeByte(PCF8563_STAT2_REG, 1, _data);
+template <typename Chip>
+void PCF8563_Driver<Chip>::enableAlarm() {
+    uint8_t data[1];
+
+    _readByte(Chip::CTRL2_REG, 1, data);
+    data[0] &= ~Chip::ALARM_AF;
+    data[0] |= (Chip::TIMER_TF | Chip::ALARM_AIE);
+    _writeByte(Chip::CTRL2_REG, 1, data);
 }
 
-void PCF8563_Class::disableAlarm() {
-    _readByte(PCF8563_STAT2_REG, 1, _data);
-    _data[0] &= ~(PCF8563_ALARM_AF | PCF8563_ALARM_AIE);
-    _data[0] |= PCF8563_TIMER_TF;
-    _writeByte(PCF8563_STAT2_REG, 1, _data);
+template <typename Chip>
+void PCF8563_Driver<Chip>::disableAlarm() {
+    uint8_t data[1];
+
+    _readByte(Chip::CTRL2_REG, 1, data);
+    data[0] &= ~(Chip::ALARM_AF | Chip::ALARM_AIE);
+    data[0] |= Chip::TIMER_TF;
+    _writeByte(Chip::CTRL2_REG, 1, data);
 }
 
-void PCF8563_Class::resetAlarm() {
-    _readByte(PCF8563_STAT2_REG, 1, _data);
-    _data[0] &= ~(PCF8563_ALARM_AF);
-    _data[0] |= PCF8563_TIMER_TF;
-    _writeByte(PCF8563_STAT2_REG, 1, _data);
+template <typename Chip>
+void PCF8563_Driver<Chip>::resetAlarm() {
+    uint8_t data[1];
+
+    _readByte(Chip::CTRL2_REG, 1, data);
+    data[0] &= ~(Chip::ALARM_AF);
+    data[0] |= Chip::TIMER_TF;
+    _writeByte(Chip::CTRL2_REG, 1, data);
 }
 
-bool PCF8563_Class::alarmActive() {
-    _readByte(PCF8563_STAT2_REG, 1, _data);
-    return (bool)(_data[0] & PCF8563_ALARM_AF);
+template <typename Chip>
+bool PCF8563_Driver<Chip>::alarmActive() {
+    uint8_t data[1];
+
+    _readByte(Chip::CTRL2_REG, 1, data);
+    return (bool)(data[0] & Chip::ALARM_AF);
 }
 
-void PCF8563_Class::setAlarm(RTC_Alarm alarm) {
+template <typename Chip>
+void PCF8563_Driver<Chip>::setAlarm(const RTC_Alarm &alarm) {
     setAlarm(alarm.minute, alarm.hour, alarm.day, alarm.weekday);
 }
 
-void PCF8563_Class::setAlarm(uint8_t hour, uint8_t minute, uint8_t day, uint8_t weekday) {
-    _data[0] = PCF8563_ALARM_ENABLE;
+template <typename Chip>
+void PCF8563_Driver<Chip>::setAlarm(uint8_t hour, uint8_t minute, uint8_t day, uint8_t weekday) {
+    uint8_t data[4];
+
+    data[0] = PCF8563_ALARM_ENABLE;
     if (minute != PCF8563_NO_ALARM) {
-        _data[0] = _dec_to_bcd(constrain(minute, 0, 59));
-        _data[0] &= ~PCF8563_ALARM_ENABLE;
+        data[0] = _dec_to_bcd(constrain(minute, 0, 59));
+        data[0] &= ~PCF8563_ALARM_ENABLE;
     }
 
-    _data[1] = PCF8563_ALARM_ENABLE;
+    data[1] = PCF8563_ALARM_ENABLE;
     if (hour != PCF8563_NO_ALARM) {
-        _data[1] = _dec_to_bcd(constrain(hour, 0, 23));
-        _data[1] &= ~PCF8563_ALARM_ENABLE;
+        data[1] = _dec_to_bcd(constrain(hour, 0, 23));
+        data[1] &= ~PCF8563_ALARM_ENABLE;
     }
 
     if (day != PCF8563_NO_ALARM) {
-        _data[2] = _dec_to_bcd(constrain(day, 1, 31));
-        _data[2] &= ~PCF8563_ALARM_ENABLE;
+        data[2] = _dec_to_bcd(constrain(day, 1, 31));
+        data[2] &= ~PCF8563_ALARM_ENABLE;
     } else {
-        _data[2] = PCF8563_ALARM_ENABLE;
+        data[2] = PCF8563_ALARM_ENABLE;
     }
 
     if (weekday != PCF8563_NO_ALARM) {
-        _data[3] = _dec_to_bcd(constrain(weekday, 0, 6));
-        _data[3] &= ~PCF8563_ALARM_ENABLE;
+        data[3] = _dec_to_bcd(constrain(weekday, 0, 6));
+        data[3] &= ~PCF8563_ALARM_ENABLE;
     } else {
-        _data[3] = PCF8563_ALARM_ENABLE;
+        data[3] = PCF8563_ALARM_ENABLE;
     }
 
-    _writeByte(PCF8563_ALRM_MIN_REG, 4, _data);
+    _writeByte(Chip::ALRM_MIN_REG, 4, data);
 }
 
-void PCF8563_Class::setAlarmByMinutes(uint8_t minute) {
+template <typename Chip>
+void PCF8563_Driver<Chip>::setAlarmByMinutes(uint8_t minute) {
     setAlarm(PCF8563_NO_ALARM, minute, PCF8563_NO_ALARM, PCF8563_NO_ALARM);
 }
 
-void PCF8563_Class::setAlarmByDays(uint8_t day) {
+template <typename Chip>
+void PCF8563_Driver<Chip>::setAlarmByDays(uint8_t day) {
     setAlarm(PCF8563_NO_ALARM, PCF8563_NO_ALARM, day, PCF8563_NO_ALARM);
 }
 
-void PCF8563_Class::setAlarmByHours(uint8_t hour) {
+template <typename Chip>
+void PCF8563_Driver<Chip>::setAlarmByHours(uint8_t hour) {
     setAlarm(hour, PCF8563_NO_ALARM, PCF8563_NO_ALARM, PCF8563_NO_ALARM);
 }
 
-void PCF8563_Class::setAlarmByWeekDay(uint8_t weekday) {
+template <typename Chip>
+void PCF8563_Driver<Chip>::setAlarmByWeekDay(uint8_t weekday) {
     setAlarm(PCF8563_NO_ALARM, PCF8563_NO_ALARM, PCF8563_NO_ALARM, weekday);
 }
 
-bool PCF8563_Class::isTimerEnable() {
-    _readByte(PCF8563_STAT2_REG, 1, &_data[0]);
-    _readByte(PCF8563_TIMER1_REG, 1, &_data[1]);
+#if PCF8563_ENABLE_TIMER
+template <typename Chip>
+bool PCF8563_Driver<Chip>::isTimerEnable() {
+    uint8_t data[2];
 
-    return _data[0] & PCF8563_TIMER_TIE && _data[1] & PCF8563_TIMER_TE;
+    _readByte(Chip::CTRL2_REG, 1, &data[0]);
+    _readByte(Chip::TIMER_CTL_REG, 1, &data[1]);
+
+    return ((data[0] & Chip::CTRL2_TIE) | (data[1] & Chip::TIMER_CTL_TIE)) && data[1] & Chip::TIMER_TE;
 }
 
-bool PCF8563_Class::isTimerActive() {
-    _readByte(PCF8563_STAT2_REG, 1, _data);
-    return (bool)_data[0] & PCF8563_TIMER_TF;
+template <typename Chip>
+bool PCF8563_Driver<Chip>::isTimerActive() {
+    uint8_t data[1];
+
+    _readByte(Chip::CTRL2_REG, 1, data);
+    return (bool)(data[0] & Chip::TIMER_TF);
 }
 
-void PCF8563_Class::enableTimer() {
-    _readByte(PCF8563_STAT2_REG, 1, &_data[0]);
-    _readByte(PCF8563_TIMER1_REG, 1, &_data[1]);
-    _data[0] &= ~PCF8563_TIMER_TF;
-    _data[0] |= (PCF8563_ALARM_AF | PCF8563_TIMER_TIE);
-    _data[1] |= PCF8563_TIMER_TE;
-    _writeByte(PCF8563_STAT2_REG, 1, &_data[0]);
-    _writeByte(PCF8563_TIMER1_REG, 1, &_data[1]);
+template <typename Chip>
+void PCF8563_Driver<Chip>::enableTimer() {
+    uint8_t data[2];
+
+    _readByte(Chip::CTRL2_REG, 1, &data[0]);
+    _readByte(Chip::TIMER_CTL_REG, 1, &data[1]);
+    data[0] &= ~Chip::TIMER_TF;
+    data[0] |= (Chip::ALARM_AF | Chip::CTRL2_TIE);
+    data[1] |= (Chip::TIMER_TE | Chip::TIMER_CTL_TIE);
+    _writeByte(Chip::CTRL2_REG, 1, &data[0]);
+    _writeByte(Chip::TIMER_CTL_REG, 1, &data[1]);
 }
 
-void PCF8563_Class::disableTimer() {
-    _readByte(PCF8563_STAT2_REG, 1, _data);
-    _data[0] &= ~PCF8563_TIMER_TF;
-    _data[1] |= PCF8563_ALARM_AF;
-    _writeByte(PCF8563_STAT2_REG, 1, _data);
+template <typename Chip>
+void PCF8563_Driver<Chip>::disableTimer() {
+    uint8_t data[1];
+
+    _readByte(Chip::CTRL2_REG, 1, data);
+    data[0] &= ~Chip::TIMER_TF;
+    data[0] |= Chip::ALARM_AF;
+    _writeByte(Chip::CTRL2_REG, 1, data);
 }
 
-void PCF8563_Class::setTimer(uint8_t val, uint8_t freq, bool enIntrrupt) {
-    _readByte(PCF8563_STAT2_REG, 1, &_data[0]);
-    _readByte(PCF8563_TIMER1_REG, 1, &_data[1]);
+template <typename Chip>
+void PCF8563_Driver<Chip>::setTimer(uint8_t val, uint8_t freq, bool enIntrrupt) {
+    uint8_t data[3];
+
+    _readByte(Chip::CTRL2_REG, 1, &data[0]);
+    _readByte(Chip::TIMER_CTL_REG, 1, &data[1]);
 
     if (enIntrrupt) {
-        _data[0] |= 1 << 4;
+        data[0] |= Chip::CTRL2_TI_TP;
+        data[1] |= Chip::TIMER_CTL_TI_TP;
     } else {
-        _data[0] &= ~(1 << 4);
+        data[0] &= ~Chip::CTRL2_TI_TP;
+        data[1] &= ~Chip::TIMER_CTL_TI_TP;
     }
 
-    _data[1] |= (freq & PCF8563_TIMER_TD10);
-    _data[2] = val;
-    _writeByte(PCF8563_STAT2_REG, 1, &_data[0]);
-    _writeByte(PCF8563_TIMER1_REG, 1, &_data[1]);
-    _writeByte(PCF8563_TIMER2_REG, 1, &_data[2]);
+    data[1] |= (freq & PCF8563_TIMER_TD10) << Chip::TIMER_FREQ_POS;
+    data[2] = val;
+    _writeByte(Chip::CTRL2_REG, 1, &data[0]);
+    _writeByte(Chip::TIMER_CTL_REG, 1, &data[1]);
+    _writeByte(Chip::TIMER_VAL_REG, 1, &data[2]);
 }
 
-void PCF8563_Class::clearTimer() {
-    _readByte(PCF8563_STAT2_REG, 1, _data);
-    _data[0] &= ~(PCF8563_TIMER_TF | PCF8563_TIMER_TIE);
-    _data[0] |= PCF8563_ALARM_AF;
-    _data[1] = 0x00;
-    _writeByte(PCF8563_STAT2_REG, 1, &_data[0]);
-    _writeByte(PCF8563_TIMER1_REG, 1, &_data[1]);
+template <typename Chip>
+void PCF8563_Driver<Chip>::clearTimer() {
+    uint8_t data[2];
+
+    _readByte(Chip::CTRL2_REG, 1, data);
+    data[0] &= ~(Chip::TIMER_TF | Chip::CTRL2_TIE);
+    data[0] |= Chip::ALARM_AF;
+    data[1] = 0x00;
+    _writeByte(Chip::CTRL2_REG, 1, &data[0]);
+    _writeByte(Chip::TIMER_CTL_REG, 1, &data[1]);
 }
+#endif
 
-bool PCF8563_Class::enableCLK(uint8_t freq) {
-    if (freq >= PCF8563_CLK_MAX) {
+template <typename Chip>
+bool PCF8563_Driver<Chip>::enableCLK(uint8_t freq) {
+    if (freq >= PCF8563_CLK_MAX || Chip::clk(freq) == PCF8563_CLK_UNSUPPORTED) {
         return false;
     }
 
-    _data[0] = freq | PCF8563_CLK_ENABLE;
-    _writeByte(PCF8563_SQW_REG, 1, _data);
+    uint8_t data[1] = { 0x00 };
+
+    if (Chip::CLK_KEEP) {
+        _readByte(Chip::CLK_REG, 1, data);
+    }
+
+    data[0] = (data[0] & Chip::CLK_KEEP) | Chip::clk(freq);
+    _writeByte(Chip::CLK_REG, 1, data);
 
     return true;
 }
 
-void PCF8563_Class::disableCLK() {
-    _data[0] = 0x00;
-    _writeByte(PCF8563_SQW_REG, 1, _data);
+template <typename Chip>
+void PCF8563_Driver<Chip>::disableCLK() {
+    uint8_t data[1] = { 0x00 };
+
+    if (Chip::CLK_KEEP) {
+        _readByte(Chip::CLK_REG, 1, data);
+    }
+
+    data[0] = (data[0] & Chip::CLK_KEEP) | Chip::CLK_OFF;
+    _writeByte(Chip::CLK_REG, 1, data);
+}
+
+template <typename Chip>
+bool PCF8563_Driver<Chip>::setOffset(int8_t steps, bool coarse) {
+    if (!Chip::HAS_OFFSET || steps < PCF85063_OFFSET_MIN || steps > PCF85063_OFFSET_MAX) {
+        return false;
+    }
+
+    uint8_t data[1];
+
+    data[0] = (steps & PCF85063_OFFSET_MASK) | (coarse ? PCF85063_OFFSET_MODE : 0x00);
+    _writeByte(Chip::OFFSET_REG, 1, data);
+
+    return true;
 }
 
-const char *PCF8563_Class::formatDateTime(uint8_t sytle) {
+template <typename Chip>
+int8_t PCF8563_Driver<Chip>::getOffset() {
+    if (!Chip::HAS_OFFSET) {
+        return 0;
+    }
+
+    uint8_t data[1];
+
+    _readByte(Chip::OFFSET_REG, 1, data);
+
+    // Sign extend the 7-bit two's complement value.
+    return (int8_t)(data[0] << 1) >> 1;
+}
+
+template <typename Chip>
+bool PCF8563_Driver<Chip>::correctDrift(int32_t ppb) {
+    // Out of range either way; rejecting first also keeps the rounding below from overflowing.
+    if (ppb > -PCF85063_OFFSET_MIN * PCF85063_OFFSET_PPB || ppb < PCF85063_OFFSET_MIN * PCF85063_OFFSET_PPB) {
+        return false;
+    }
+
+    // A clock running fast (positive ppb) needs a negative offset; round to the nearest normal mode step.
+    int32_t steps = -(ppb + (ppb < 0 ? -PCF85063_OFFSET_PPB : PCF85063_OFFSET_PPB) / 2) / PCF85063_OFFSET_PPB;
+
+    if (steps < PCF85063_OFFSET_MIN || steps > PCF85063_OFFSET_MAX) {
+        return false;
+    }
+
+    return setOffset(steps, false);
+}
+
+#if PCF8563_ENABLE_FORMAT
+static char format[PCF8563_FORMAT_LEN];
+
+template <typename Chip>
+const char *PCF8563_Driver<Chip>::formatDateTime(uint8_t sytle) {
+    return formatDateTime(format, sizeof(format), sytle);
+}
+
+template <typename Chip>
+char *PCF8563_Driver<Chip>::formatDateTime(char *buf, size_t len, uint8_t sytle) {
     RTC_Date t = getDateTime();
 
     switch (sytle) {
         case PCF_TIMEFORMAT_HM:
-            snprintf(format, sizeof(format), "%d:%d", t.hour, t.minute);
+            snprintf(buf, len, "%d:%d", t.hour, t.minute);
             break;
 
         case PCF_TIMEFORMAT_HMS:
-            snprintf(format, sizeof(format), "%d:%d:%d", t.hour, t.minute, t.second);
+            snprintf(buf, len, "%d:%d:%d", t.hour, t.minute, t.second);
             break;
 
         case PCF_TIMEFORMAT_YYYY_MM_DD:
-            snprintf(format, sizeof(format), "%d-%d-%d", t.year, t.month, t.day);
+            snprintf(buf, len, "%d-%d-%d", t.year, t.month, t.day);
             break;
 
         case PCF_TIMEFORMAT_MM_DD_YYYY:
-            snprintf(format, sizeof(format), "%d-%d-%d", t.month, t.day, t.year);
+            snprintf(buf, len, "%d-%d-%d", t.month, t.day, t.year);
             break;
 
         case PCF_TIMEFORMAT_DD_MM_YYYY:
-            snprintf(format, sizeof(format), "%d-%d-%d", t.day, t.month, t.year);
+            snprintf(buf, len, "%d-%d-%d", t.day, t.month, t.year);
             break;
 
         case PCF_TIMEFORMAT_YYYY_MM_DD_H_M_S:
-            snprintf(format, sizeof(format), "%d-%d-%d/%d:%d:%d", t.year, t.month, t.day, t.hour, t.minute, t.second);
+            snprintf(buf, len, "%d-%d-%d/%d:%d:%d", t.year, t.month, t.day, t.hour, t.minute, t.second);
             break;
 
         default:
-            snprintf(format, sizeof(format), "%d:%d", t.hour, t.minute);
+            snprintf(buf, len, "%d:%d", t.hour, t.minute);
             break;
     }
 
-    return format;
+    return buf;
 }
+#endif
 
+#if PCF8563_ENABLE_SYNC
 #ifdef ESP32
-void PCF8563_Class::syncToSystem() {
-    if (PCF8563_Class::isValid()) {
+template <typename Chip>
+void PCF8563_Driver<Chip>::syncToSystem() {
+    if (isValid()) {
         struct tm t_tm;
         struct timeval val;
 
@@ -324,9 +462,73 @@ void PCF8563_Class::syncToSystem() {
 
     ESP_LOGE("RTC Time is not Valid", "System Epoch Not Set");
 }
+
+template <typename Chip>
+bool PCF8563_Driver<Chip>::syncToSystemPrecise(int32_t *errorUs) {
+    if (!isValid()) {
+        ESP_LOGE("RTC Time is not Valid", "System Epoch Not Set");
+        return false;
+    }
+
+    uint8_t data[1];
+
+    // Poll the seconds register; the rollover happened between the last two sample points.
+    uint32_t started  = micros();
+    uint32_t previous = started;
+    uint32_t sample;
+    uint32_t before;
+    uint8_t  last = 0xFF;
+    uint8_t  second;
+
+    for (;;) {
+        before = micros();
+        _readByte(Chip::SEC_REG, 1, data);
+        sample = before + (micros() - before) / 2;
+        second = data[0] & (~PCF8563_VOL_LOW_MASK);
+
+        if (last != 0xFF && second != last) {
+            break;
+        }
+
+        if (sample - started > PCF8563_SYNC_TIMEOUT_US) {
+            ESP_LOGE("RTC seconds did not roll over", "System Epoch Not Set");
+            return false;
+        }
+
+        last     = second;
+        previous = sample;
+    }
+
+    uint32_t rollover = previous + (sample - previous) / 2;
+
+    struct tm t_tm = {};
+    struct timeval val;
+
+    RTC_Date dt  = getDateTime();
+    t_tm.tm_hour = dt.hour;
+    t_tm.tm_min  = dt.minute;
+    t_tm.tm_sec  = dt.second;
+    t_tm.tm_year = dt.year - 1900;
+    t_tm.tm_mon  = dt.month - 1;
+    t_tm.tm_mday = dt.day;
+
+    // Carry the time spent since the rollover over into the sub-second phase.
+    uint32_t elapsed = micros() - rollover;
+    val.tv_sec       = mktime(&t_tm) + elapsed / 1000000;
+    val.tv_usec      = elapsed % 1000000;
+
+    settimeofday(&val, NULL);
+
+    if (errorUs) {
+        *errorUs = (sample - previous) / 2;
+    }
+
+    return true;
+}
 #endif
 
-bool PCF8563_Class::syncToRtcUsingGmt() {
+template <typename Chip>
+bool PCF8563_Driver<Chip>::syncToRtcUsingGmt() {
     time_t epoch;
     struct tm gmt;
     time(&epoch);
@@ -346,7 +548,8 @@ bool PCF8563_Class::syncToRtcUsingGmt() {
     return false;
 }
 
-bool PCF8563_Class::syncToRtc(bool useGmt = false) {
+template <typename Chip>
+bool PCF8563_Driver<Chip>::syncToRtc(bool useGmt) {
     if (useGmt) {
         return syncToRtcUsingGmt();
     }
@@ -360,7 +563,78 @@ bool PCF8563_Class::syncToRtc(bool useGmt = false) {
     return true;
 }
 
-uint8_t PCF8563_Class::status2() {
-    _readByte(PCF8563_STAT2_REG, 1, _data);
-    return _data[0];
+template <typename Chip>
+bool PCF8563_Driver<Chip>::syncToRtcPrecise(bool useGmt, int32_t *errorUs) {
+    int64_t now = systemTimeUs();
+
+    // Is epoch is between 1970 and 2100?
+    if (now <= 0 || now >= 4102444800LL * 1000000) {
+        #ifdef ESP32
+        ESP_LOGE("ESP32 Time is not Valid", "RTC Time Not Set");
+        #endif
+
+        return false;
+    }
+
+    // Releasing STOP this far into second T makes the first increment, to T + 1, land on the system's next second.
+    const int32_t releaseAt = 1000000 - PCF8563_STOP_RELEASE_US;
+    time_t second           = now / 1000000;
+
+    if ((int32_t)(now % 1000000) + PCF8563_SYNC_SETUP_US > releaseAt) {
+        ++second;
+    }
+
+    // Keep whatever CTRL1 settings the chip has besides STOP.
+    uint8_t ctrl1[1] = { 0x00 };
+    if (Chip::CTRL1_KEEP) {
+        _readByte(Chip::CTRL1_REG, 1, ctrl1);
+        ctrl1[0] &= Chip::CTRL1_KEEP;
+    }
+
+    // Hold the prescaler, timing the write so the release can be started early by the same amount.
+    uint8_t data[1];
+    int64_t started = systemTimeUs();
+    data[0]         = ctrl1[0] | PCF8563_STOP_BIT;
+    _writeByte(Chip::CTRL1_REG, 1, data);
+    int64_t writeUs = systemTimeUs() - started;
+
+    struct tm info;
+    if (useGmt) {
+        gmtime_r(&second, &info);
+    } else {
+        localtime_r(&second, &info);
+    }
+
+    setDateTime(info.tm_year + 1900, info.tm_mon + 1, info.tm_mday, info.tm_hour, info.tm_min, info.tm_sec);
+
+    int64_t deadline = (int64_t)second * 1000000 + releaseAt;
+    while ((now = systemTimeUs()) < deadline - writeUs) {
+        if (deadline - now > 2000) {
+            delay(1);
+        }
+    }
+
+    data[0] = ctrl1[0];
+    _writeByte(Chip::CTRL1_REG, 1, data);
+
+    // STOP is latched at the end of the data byte, so the end of the write is the release point.
+    if (errorUs) {
+        *errorUs = (int32_t)(systemTimeUs() - deadline);
+    }
+
+    return true;
+}
+#endif
+
+template <typename Chip>
+uint8_t PCF8563_Driver<Chip>::status2() {
+    uint8_t data[1];
+
+    _readByte(Chip::CTRL2_REG, 1, data);
+    return data[0];
 }
+
+template class PCF8563_Driver<PCF8563_Chip>;
+template class PCF8563_Driver<BM8563_Chip>;
+template class PCF8563_Driver<HYM8563_Chip>;
+template class PCF8563_Driver<PCF85063_Chip>;
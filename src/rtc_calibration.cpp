@@ -0,0 +1,165 @@
+#include "rtc_calibration.h"
+
+#ifndef IRAM_ATTR
+#define IRAM_ATTR
+#endif
+
+RTC_Calibration::RTC_Calibration(uint32_t refHz, uint32_t windowUs)
+    : _refHz(refHz), _windowUs(windowUs), _gapUs(1500000 / refHz) {
+}
+
+#ifdef ARDUINO
+RTC_Calibration *RTC_Calibration::_active = NULL;
+
+void IRAM_ATTR RTC_Calibration::_isr() {
+    _active->edge(::micros());
+}
+
+void RTC_Calibration::begin(uint8_t pin) {
+    _pin    = pin;
+    _active = this;
+
+    // CLKOUT is open drain.
+    pinMode(pin, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(pin), _isr, FALLING);
+}
+
+void RTC_Calibration::end() {
+    detachInterrupt(digitalPinToInterrupt(_pin));
+    _active = NULL;
+}
+
+uint32_t RTC_Calibration::micros() {
+    update();
+    return correct(::micros());
+}
+#endif
+
+bool IRAM_ATTR RTC_Calibration::edge(uint32_t mcuUs) {
+    // A gap of more than 1.5 periods means edges were missed (sleep, flash stall), which would read
+    // as a large negative error. Drop the window so far and start a new one from this edge.
+    if (_edges == 0 || mcuUs - _last > _gapUs) {
+        _first = mcuUs;
+        _edges = 0;
+    }
+
+    _last = mcuUs;
+    _edges = _edges + 1;
+
+    if (_last - _first < _windowUs) {
+        return false;
+    }
+
+    // Close the window; this edge also opens the next one so no time is lost between windows.
+    // If update() has fallen behind, drop the older windows rather than let _pendingUs wrap.
+    if (_pendingUs > RTC_CALIBRATION_MAX_PENDING) {
+        _pendingPeriods = 0;
+        _pendingUs      = 0;
+    }
+
+    _pendingPeriods = _pendingPeriods + (_edges - 1);
+    _pendingUs      = _pendingUs + (_last - _first);
+    _pendingEnd     = _last;
+    _first          = _last;
+    _edges          = 1;
+
+    return true;
+}
+
+bool RTC_Calibration::update() {
+    #ifdef ARDUINO
+    noInterrupts();
+    #endif
+    uint32_t periods = _pendingPeriods;
+    uint32_t elapsed = _pendingUs;
+    uint32_t end     = _pendingEnd;
+    _pendingPeriods  = 0;
+    _pendingUs       = 0;
+    #ifdef ARDUINO
+    interrupts();
+    #endif
+
+    return addWindow(periods, elapsed, end);
+}
+
+bool RTC_Calibration::addWindow(uint32_t periods, uint32_t elapsedUs, uint32_t endUs) {
+    if (periods == 0) {
+        return false;
+    }
+
+    // (elapsed - expected) / expected, with expected = periods / refHz, scaled to ppb.
+    int64_t diff     = (int64_t)elapsedUs * _refHz - (int64_t)periods * 1000000;
+    int64_t measured = diff * 1000 / periods;
+
+    if (measured > RTC_CALIBRATION_MAX_PPB || measured < -RTC_CALIBRATION_MAX_PPB) {
+        return false;
+    }
+
+    // Re-anchor at the end of the window so the corrected clock stays continuous across the rate change.
+    _anchorOut = _map(endUs);
+    _anchorRaw = endUs;
+
+    if (_calibrated) {
+        _ppb += (int32_t)((measured - _ppb) / (1 << _smoothing));
+    } else {
+        _ppb        = (int32_t)measured;
+        _calibrated = true;
+    }
+
+    return true;
+}
+
+int64_t RTC_Calibration::_delta(uint32_t rawUs) {
+    // Up to one window before the anchor is a timestamp captured before update() re-anchored;
+    // anything else is forward, so gaps of up to 2^32 us work like the raw clock does.
+    uint32_t behind = _anchorRaw - rawUs;
+    if (behind <= _windowUs) {
+        return -(int64_t)behind;
+    }
+
+    return (int64_t)(uint32_t)(rawUs - _anchorRaw);
+}
+
+uint32_t RTC_Calibration::_map(uint32_t rawUs) {
+    return _anchorOut + (uint32_t)(_delta(rawUs) * 1000000000 / (1000000000 + _ppb));
+}
+
+uint32_t RTC_Calibration::correct(uint32_t rawUs) {
+    uint32_t out = _map(rawUs);
+
+    if (_delta(rawUs) >= (int64_t)RTC_CALIBRATION_REBASE) {
+        _anchorRaw = rawUs;
+        _anchorOut = out;
+    }
+
+    // Never step backwards, even right after a new estimate has been applied. Rate changes only
+    // move the output back by a fraction of a window; larger differences are forward progress.
+    if (_hasOut && (uint32_t)(_lastOut - out) <= _windowUs) {
+        out = _lastOut;
+    }
+
+    _lastOut = out;
+    _hasOut  = true;
+
+    return out;
+}
+
+int32_t RTC_Calibration::ppb() {
+    return _ppb;
+}
+
+float RTC_Calibration::ppm() {
+    return _ppb / 1000.0f;
+}
+
+bool RTC_Calibration::isCalibrated() {
+    return _calibrated;
+}
+
+void RTC_Calibration::setWindow(uint32_t windowUs) {
+    _windowUs = windowUs;
+}
+
+void RTC_Calibration::setSmoothing(uint8_t shift) {
+    _smoothing = shift;
+}
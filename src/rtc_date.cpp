@@ -80,6 +80,6 @@ RTC_Date::RTC_Date(const char *date, const char *time) {
     second = StringToUint8(time + 6);
 }
 
-bool RTC_Date::operator==(RTC_Date d) {
+bool RTC_Date::operator==(const RTC_Date &d) const {
     return ((d.year == year) && (d.month == month) && (d.day == day) && (d.hour == hour) && (d.minute == minute));
 }
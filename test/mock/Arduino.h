@@ -0,0 +1,18 @@
+#pragma once
+
+// Minimal Arduino core for host tests.
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+inline uint32_t micros()
+{
+    return 0;
+}
+
+inline void delay(unsigned long)
+{
+}
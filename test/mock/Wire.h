@@ -0,0 +1,71 @@
+#pragma once
+
+// Register-file TwoWire for host tests: writes land in regs, reads come from them, and the
+// way each register address write ends (stop or repeated start) is counted.
+#include <Arduino.h>
+
+class TwoWire
+{
+    public:
+        uint8_t regs[32];
+        uint8_t reg;
+        bool addressed;
+        int stops;
+        int repeatedStarts;
+        int avail;
+
+        TwoWire() : regs(), reg(0), addressed(false), stops(0), repeatedStarts(0), avail(0)
+        {
+        }
+
+        void begin()
+        {
+        }
+
+        void beginTransmission(uint8_t)
+        {
+            addressed = false;
+        }
+
+        size_t write(uint8_t val)
+        {
+            if (addressed) {
+                regs[reg++] = val;
+            } else {
+                reg       = val;
+                addressed = true;
+            }
+
+            return 1;
+        }
+
+        uint8_t endTransmission(bool sendStop = true)
+        {
+            if (sendStop) {
+                ++stops;
+            } else {
+                ++repeatedStarts;
+            }
+
+            return 0;
+        }
+
+        uint8_t requestFrom(uint8_t, uint8_t nbytes, uint8_t)
+        {
+            avail = nbytes;
+            return nbytes;
+        }
+
+        int available()
+        {
+            return avail;
+        }
+
+        int read()
+        {
+            --avail;
+            return regs[reg++];
+        }
+};
+
+extern TwoWire Wire;
@@ -0,0 +1,174 @@
+#include <stdint.h>
+#include "rtc_calibration.h"
+#include "unity.h"
+
+#define REF_HZ 1024
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+// Replays the CLKOUT edges an MCU running ppm fast would have timestamped from startUs on.
+static void replay(RTC_Calibration &cal, double ppm, uint32_t edges, double startUs)
+{
+    for (uint32_t i = 0; i < edges; ++i) {
+        double mcuUs = startUs + (i * 1000000.0 / REF_HZ) * (1.0 + ppm / 1000000.0);
+        if (cal.edge((uint32_t)mcuUs)) {
+            cal.update();
+        }
+    }
+}
+
+void test_measures_fast_clock(void)
+{
+    RTC_Calibration cal(REF_HZ, 1000000);
+
+    TEST_ASSERT_FALSE(cal.isCalibrated());
+    replay(cal, 50.0, REF_HZ * 5 + 1, 0);
+
+    TEST_ASSERT_TRUE(cal.isCalibrated());
+    TEST_ASSERT_INT32_WITHIN(1000, 50000, cal.ppb());
+}
+
+void test_measures_slow_clock_with_pulse_count(void)
+{
+    RTC_Calibration cal(32768, 1000000);
+
+    // 32768 periods took 999970 us of MCU time: -30 ppm.
+    TEST_ASSERT_TRUE(cal.addWindow(32768, 999970, 999970));
+    TEST_ASSERT_INT32_WITHIN(10, -30000, cal.ppb());
+}
+
+void test_rejects_empty_and_absurd_windows(void)
+{
+    RTC_Calibration cal(REF_HZ, 1000000);
+
+    TEST_ASSERT_FALSE(cal.addWindow(0, 1000000, 1000000));
+    TEST_ASSERT_FALSE(cal.addWindow(REF_HZ, 2000000, 2000000));
+    TEST_ASSERT_FALSE(cal.isCalibrated());
+}
+
+void test_corrected_clock_tracks_reference(void)
+{
+    RTC_Calibration cal(REF_HZ, 1000000);
+    const double ppm = 200.0;
+
+    replay(cal, ppm, REF_HZ * 4 + 1, 0);
+
+    // Over ten seconds of true time the raw clock gains 2 ms; the corrected one does not.
+    uint32_t start = cal.correct((uint32_t)(4000000.0 * (1.0 + ppm / 1000000.0)));
+    uint32_t end   = cal.correct((uint32_t)(14000000.0 * (1.0 + ppm / 1000000.0)));
+    TEST_ASSERT_UINT32_WITHIN(50, 10000000, end - start);
+}
+
+void test_follows_drift_and_stays_monotonic(void)
+{
+    RTC_Calibration cal(REF_HZ, 1000000);
+
+    replay(cal, 100.0, REF_HZ * 2 + 1, 0);
+
+    replay(cal, -100.0, REF_HZ * 20 + 1, 2000200);
+    TEST_ASSERT_INT32_WITHIN(5000, -100000, cal.ppb());
+
+    uint32_t last = 0;
+    for (uint32_t raw = 22000000; raw < 23000000; raw += 997) {
+        uint32_t now = cal.correct(raw);
+        TEST_ASSERT_TRUE(now >= last);
+        last = now;
+    }
+}
+
+void test_maps_timestamps_before_anchor(void)
+{
+    RTC_Calibration cal(REF_HZ, 1000000);
+
+    // Windows close at raw 1000100 and 2000200; the anchor ends up at 2000200 -> 2000100.
+    replay(cal, 100.0, REF_HZ * 2 + 1, 0);
+    TEST_ASSERT_INT32_WITHIN(10, 100000, cal.ppb());
+
+    // 200 us of raw time before the anchor is 199.98 us of corrected time.
+    TEST_ASSERT_UINT32_WITHIN(2, 1999900, cal.correct(2000000));
+    TEST_ASSERT_UINT32_WITHIN(2, 2000100 + 999900, cal.correct(3000200));
+}
+
+void test_never_steps_back_across_update(void)
+{
+    RTC_Calibration cal(REF_HZ, 1000000);
+    cal.setSmoothing(0);
+
+    TEST_ASSERT_TRUE(cal.addWindow(REF_HZ, 1000000, 1000000));
+    TEST_ASSERT_EQUAL_INT32(0, cal.ppb());
+    TEST_ASSERT_EQUAL_UINT32(1500000, cal.correct(1500000));
+
+    // A window that closed at 1.4 s is only processed now, at +1000 ppm: the new rate maps
+    // 1.5 s to 1499900, behind what was already returned, so the clock holds instead.
+    TEST_ASSERT_TRUE(cal.addWindow(REF_HZ, 1001000, 1400000));
+    TEST_ASSERT_EQUAL_INT32(1000000, cal.ppb());
+    TEST_ASSERT_EQUAL_UINT32(1500000, cal.correct(1500000));
+    TEST_ASSERT_UINT32_WITHIN(1, 1599800, cal.correct(1600000));
+}
+
+void test_discards_window_with_missed_edges(void)
+{
+    RTC_Calibration cal(REF_HZ, 1000000);
+
+    // Twenty edges lost in the first second, as in a short light sleep.
+    for (uint32_t i = 0; i <= REF_HZ * 3; ++i) {
+        if (i >= 500 && i < 520) {
+            continue;
+        }
+
+        if (cal.edge((uint32_t)(i * 1000000.0 / REF_HZ * (1.0 + 50.0 / 1000000.0)))) {
+            cal.update();
+        }
+    }
+
+    TEST_ASSERT_TRUE(cal.isCalibrated());
+    TEST_ASSERT_INT32_WITHIN(1000, 50000, cal.ppb());
+}
+
+void test_keeps_running_across_long_idle(void)
+{
+    RTC_Calibration cal(REF_HZ, 1000000);
+
+    replay(cal, 100.0, REF_HZ * 2 + 1, 0);
+    TEST_ASSERT_UINT32_WITHIN(2, 1999900, cal.correct(2000000));
+
+    // More than 2^31 us between calls, twice; the second one also wraps the raw clock.
+    TEST_ASSERT_UINT32_WITHIN(2, 1999900 + 2199780022UL, cal.correct(2000000 + 2200000000UL));
+    TEST_ASSERT_UINT32_WITHIN(4, (uint32_t)(1999900 + 2 * 2199780022ULL), cal.correct((uint32_t)(2000000 + 4400000000ULL)));
+}
+
+void test_update_after_long_backlog(void)
+{
+    RTC_Calibration cal(REF_HZ, 1000000);
+
+    // 4400 s of edges, longer than _pendingUs can hold, before the first update().
+    for (uint32_t i = 0; i <= REF_HZ * 4400; ++i) {
+        cal.edge((uint32_t)(uint64_t)(i * 1000000.0 / REF_HZ * (1.0 + 50.0 / 1000000.0)));
+    }
+
+    TEST_ASSERT_TRUE(cal.update());
+    TEST_ASSERT_TRUE(cal.isCalibrated());
+    TEST_ASSERT_INT32_WITHIN(1000, 50000, cal.ppb());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_measures_fast_clock);
+    RUN_TEST(test_measures_slow_clock_with_pulse_count);
+    RUN_TEST(test_rejects_empty_and_absurd_windows);
+    RUN_TEST(test_corrected_clock_tracks_reference);
+    RUN_TEST(test_follows_drift_and_stays_monotonic);
+    RUN_TEST(test_maps_timestamps_before_anchor);
+    RUN_TEST(test_never_steps_back_across_update);
+    RUN_TEST(test_discards_window_with_missed_edges);
+    RUN_TEST(test_keeps_running_across_long_idle);
+    RUN_TEST(test_update_after_long_backlog);
+    return UNITY_END();
+}
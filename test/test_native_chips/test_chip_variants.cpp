@@ -0,0 +1,183 @@
+#include <Arduino.h>
+#include <Wire.h>
+#include "pcf8563.h"
+#include "unity.h"
+
+TwoWire Wire;
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_pcf85063_register_placement(void)
+{
+    TwoWire bus;
+    PCF85063_Class rtc;
+    rtc.begin(bus);
+
+    // Time at 0x04, no century bit in the month register, offset and RAM untouched.
+    rtc.setDateTime(2024, 5, 6, 7, 8, 9);
+    const uint8_t time[] = { 0x09, 0x08, 0x07, 0x06, 0x01, 0x05, 0x24 };
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(time, &bus.regs[PCF85063_SEC_REG], 7);
+    TEST_ASSERT_EQUAL_HEX8(0x00, bus.regs[PCF85063_OFFSET_REG]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, bus.regs[0x03]);
+
+    RTC_Date now = rtc.getDateTime();
+    TEST_ASSERT_EQUAL_UINT16(2024, now.year);
+    TEST_ASSERT_EQUAL_UINT8(5, now.month);
+    TEST_ASSERT_EQUAL_UINT8(9, now.second);
+
+    // Alarm minute at 0x0C; the second alarm at 0x0B is left alone.
+    rtc.setAlarm(12, 30, PCF8563_NO_ALARM, PCF8563_NO_ALARM);
+    const uint8_t alarm[] = { 0x30, 0x12, 0x80, 0x80 };
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(alarm, &bus.regs[PCF85063_ALRM_MIN_REG], 4);
+    TEST_ASSERT_EQUAL_HEX8(0x00, bus.regs[0x0B]);
+
+    // Timer value at 0x10; TCF, TI_TP, TE and TIE all in the mode register at 0x11.
+    rtc.setTimer(10, 2, true);
+    TEST_ASSERT_EQUAL_HEX8(10, bus.regs[PCF85063_TIMER_VAL_REG]);
+    TEST_ASSERT_EQUAL_HEX8(0x11, bus.regs[PCF85063_TIMER_MODE_REG]);
+    TEST_ASSERT_FALSE(rtc.isTimerEnable());
+
+    rtc.enableTimer();
+    TEST_ASSERT_EQUAL_HEX8(0x17, bus.regs[PCF85063_TIMER_MODE_REG]);
+    TEST_ASSERT_TRUE(rtc.isTimerEnable());
+
+    bus.regs[PCF85063_CTRL2_REG] = PCF85063_TIMER_TF;
+    TEST_ASSERT_TRUE(rtc.isTimerActive());
+}
+
+void test_pcf8563_register_placement(void)
+{
+    TwoWire bus;
+    PCF8563_Class rtc;
+    rtc.begin(bus);
+
+    rtc.setDateTime(2024, 5, 6, 7, 8, 9);
+    const uint8_t time[] = { 0x09, 0x08, 0x07, 0x06, 0x01, 0x05, 0x24 };
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(time, &bus.regs[PCF8563_SEC_REG], 7);
+
+    rtc.setTimer(10, 2, true);
+    TEST_ASSERT_EQUAL_HEX8(PCF8563_TIMER_TI_TP, bus.regs[PCF8563_STAT2_REG]);
+    TEST_ASSERT_EQUAL_HEX8(0x02, bus.regs[PCF8563_TIMER1_REG]);
+    TEST_ASSERT_EQUAL_HEX8(10, bus.regs[PCF8563_TIMER2_REG]);
+
+    rtc.enableTimer();
+    TEST_ASSERT_TRUE(rtc.isTimerEnable());
+}
+
+void test_clkout_encoding(void)
+{
+    TwoWire bus;
+    PCF85063_Class rtc;
+    rtc.begin(bus);
+
+    // COF shares CTRL2 with the alarm bits, which must survive.
+    bus.regs[PCF85063_CTRL2_REG] = PCF85063_ALARM_AIE | PCF85063_ALARM_AF;
+    TEST_ASSERT_TRUE(rtc.enableCLK(PCF8563_CLK_1HZ));
+    TEST_ASSERT_EQUAL_HEX8(0xC6, bus.regs[PCF85063_CTRL2_REG]);
+    TEST_ASSERT_TRUE(rtc.enableCLK(PCF8563_CLK_1024KHZ));
+    TEST_ASSERT_EQUAL_HEX8(0xC5, bus.regs[PCF85063_CTRL2_REG]);
+    TEST_ASSERT_TRUE(rtc.enableCLK(PCF8563_CLK_32_768KHZ));
+    TEST_ASSERT_EQUAL_HEX8(0xC0, bus.regs[PCF85063_CTRL2_REG]);
+
+    TEST_ASSERT_FALSE(rtc.enableCLK(PCF8563_CLK_32HZ));
+    TEST_ASSERT_FALSE(rtc.enableCLK(PCF8563_CLK_MAX));
+    TEST_ASSERT_EQUAL_HEX8(0xC0, bus.regs[PCF85063_CTRL2_REG]);
+
+    rtc.disableCLK();
+    TEST_ASSERT_EQUAL_HEX8(0xC7, bus.regs[PCF85063_CTRL2_REG]);
+
+    TwoWire bus2;
+    PCF8563_Class rtc2;
+    rtc2.begin(bus2);
+
+    TEST_ASSERT_TRUE(rtc2.enableCLK(PCF8563_CLK_32HZ));
+    TEST_ASSERT_EQUAL_HEX8(0x82, bus2.regs[PCF8563_SQW_REG]);
+    rtc2.disableCLK();
+    TEST_ASSERT_EQUAL_HEX8(0x00, bus2.regs[PCF8563_SQW_REG]);
+}
+
+void test_offset_register(void)
+{
+    TwoWire bus;
+    PCF85063_Class rtc;
+    rtc.begin(bus);
+
+    TEST_ASSERT_TRUE(rtc.setOffset(-3));
+    TEST_ASSERT_EQUAL_HEX8(0x7D, bus.regs[PCF85063_OFFSET_REG]);
+    TEST_ASSERT_EQUAL_INT8(-3, rtc.getOffset());
+
+    TEST_ASSERT_TRUE(rtc.setOffset(PCF85063_OFFSET_MIN));
+    TEST_ASSERT_EQUAL_HEX8(0x40, bus.regs[PCF85063_OFFSET_REG]);
+    TEST_ASSERT_EQUAL_INT8(-64, rtc.getOffset());
+
+    TEST_ASSERT_TRUE(rtc.setOffset(PCF85063_OFFSET_MAX));
+    TEST_ASSERT_EQUAL_INT8(63, rtc.getOffset());
+
+    // The MODE bit is not part of the value.
+    TEST_ASSERT_TRUE(rtc.setOffset(5, true));
+    TEST_ASSERT_EQUAL_HEX8(0x85, bus.regs[PCF85063_OFFSET_REG]);
+    TEST_ASSERT_EQUAL_INT8(5, rtc.getOffset());
+
+    TEST_ASSERT_FALSE(rtc.setOffset(-65));
+    TEST_ASSERT_FALSE(rtc.setOffset(64));
+    TEST_ASSERT_EQUAL_INT8(5, rtc.getOffset());
+
+    // Fast clocks get negative steps, rounded to the nearest 4.34 ppm.
+    TEST_ASSERT_TRUE(rtc.correctDrift(13000));
+    TEST_ASSERT_EQUAL_INT8(-3, rtc.getOffset());
+    TEST_ASSERT_TRUE(rtc.correctDrift(-13000));
+    TEST_ASSERT_EQUAL_INT8(3, rtc.getOffset());
+    TEST_ASSERT_TRUE(rtc.correctDrift(2169));
+    TEST_ASSERT_EQUAL_INT8(0, rtc.getOffset());
+    TEST_ASSERT_TRUE(rtc.correctDrift(2170));
+    TEST_ASSERT_EQUAL_INT8(-1, rtc.getOffset());
+    TEST_ASSERT_EQUAL_HEX8(0x7F, bus.regs[PCF85063_OFFSET_REG]);
+
+    TEST_ASSERT_FALSE(rtc.correctDrift(300000));
+    TEST_ASSERT_FALSE(rtc.correctDrift(-300000));
+    TEST_ASSERT_FALSE(rtc.correctDrift(INT32_MAX));
+    TEST_ASSERT_FALSE(rtc.correctDrift(INT32_MIN));
+    TEST_ASSERT_EQUAL_INT8(-1, rtc.getOffset());
+
+    // No offset register on the PCF8563 family; nothing is written.
+    TwoWire bus2;
+    PCF8563_Class rtc2;
+    rtc2.begin(bus2);
+
+    TEST_ASSERT_FALSE(rtc2.setOffset(1));
+    TEST_ASSERT_FALSE(rtc2.correctDrift(13000));
+    TEST_ASSERT_EQUAL_INT8(0, rtc2.getOffset());
+    TEST_ASSERT_EQUAL_HEX8(0x00, bus2.regs[PCF8563_STAT2_REG]);
+}
+
+void test_hym8563_read_uses_repeated_start(void)
+{
+    TwoWire bus;
+    HYM8563_Class rtc;
+    rtc.begin(bus);
+
+    // HYM8563 does not accept a stop between the register address and the read.
+    bus.stops          = 0;
+    bus.repeatedStarts = 0;
+    rtc.getDateTime();
+
+    TEST_ASSERT_EQUAL_INT(1, bus.repeatedStarts);
+    TEST_ASSERT_EQUAL_INT(0, bus.stops);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_pcf85063_register_placement);
+    RUN_TEST(test_pcf8563_register_placement);
+    RUN_TEST(test_clkout_encoding);
+    RUN_TEST(test_offset_register);
+    RUN_TEST(test_hym8563_read_uses_repeated_start);
+    return UNITY_END();
+}
@@ -20,6 +20,7 @@ void tearDown(void)
 }
 
 void test_stuff(void);
+void test_precise_sync(void);
 
 void setup()
 {
@@ -29,6 +30,7 @@ void setup()
 
     UNITY_BEGIN(); // IMPORTANT LINE!
     RUN_TEST(test_stuff);
+    RUN_TEST(test_precise_sync);
     UNITY_END(); // stop unit testing
 }
 
@@ -56,4 +58,19 @@ void test_stuff(void)
     const char* dt3 = rtc.formatDateTime(PCF_TIMEFORMAT_YYYY_MM_DD_H_M_S);
     TEST_ASSERT_EQUAL_STRING("2020-5-2/11:33:1", dt2);
 
-}
\ No newline at end of file
+}
+
+void test_precise_sync(void)
+{
+    struct timeval tv = { 1556713980, 250000 }; // 2019-05-01 12:33:00.25 UTC
+    settimeofday(&tv, NULL);
+
+    int32_t error = 0;
+    TEST_ASSERT_TRUE(rtc.syncToRtcPrecise(true, &error));
+    TEST_ASSERT_INT32_WITHIN(2000, 0, error);
+
+    // Reported as an uncertainty bound, never negative.
+    TEST_ASSERT_TRUE(rtc.syncToSystemPrecise(&error));
+    TEST_ASSERT_GREATER_OR_EQUAL_INT32(0, error);
+    TEST_ASSERT_LESS_THAN_INT32(2000, error);
+}